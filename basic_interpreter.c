@@ -2,12 +2,27 @@
 /* Code licenced under GPL */
 
 #include <stdio.h>
+#ifndef SPL_EMBED
 #include <conio.h>
+#endif
 #include <string.h>
 #include <stdlib.h>
 #include <ctype.h>
 
-#ifdef _WIN32
+/*
+ * SPL_EMBED
+ *  - 다른 소스(예: spl_fuzz.c)가 이 파일을 #include 하여 인터프리터를 같은 프로세스에서
+ *    실행할 때 정의한다.
+ *  - main은 spl_reference_main으로 이름이 바뀌고, 화면 지우기와 키 입력 대기는 생략되며,
+ *    printf 출력은 포함하는 쪽이 정의한 SplEmbedPrintf로 전달된다.
+ */
+#ifdef SPL_EMBED
+int SplEmbedPrintf(const char* fmt, ...);
+#define CLEAR() ((void)0)
+#define getch() ((void)0)
+#define printf SplEmbedPrintf
+#define main spl_reference_main
+#elif defined(_WIN32)
 #define CLEAR() system("cls")
 #else
 #define CLEAR() system("clear")
@@ -67,12 +82,14 @@ typedef struct postfixstack PostfixStack;
  *            반환값: 변수이면 값, 함수이면 -1(함수의 라인은 출력 인자로 설정), 없으면 -999.
  *  - GetLastFunctionCall: 스택을 뒤로 훑어 가장 최근에 푸시된 "함수 호출" 노드(type==3)의 라인 번호를 반환합니다.
  *  - FreeAll: 스택에 남아있는 모든 Node를 해제하고 메모리를 정리합니다.
+ *  - FreeStacks: 연산자/후위 계산/심볼 스택에 남은 노드와 세 스택 구조체를 모두 해제합니다.
  *  - my_stricmp: 대소문자 구분 없는 문자열 비교 (case-insensitive strcmp).
  *  - rstrip: 문자열 오른쪽의 개행/캐리지리턴/공백을 제거합니다.
  */
 static int GetVal(char, int*, Stack*);
 static int GetLastFunctionCall(Stack*);
 static Stack* FreeAll(Stack*);
+static void FreeStacks(OpStack*, PostfixStack*, Stack*);
 static int my_stricmp(const char* a, const char* b);
 static void rstrip(char* s);
 
@@ -227,45 +244,45 @@ static int Priotry(char operator)
  *  주요 역할(전체 흐름) 및 구현 위치(라인 번호):
  *
  *   1) 프로그램 시작:
- *      - main 진입부 선언:                             (라인: 279)
- *      - 화면 초기화(CLEAR) 호출:                     (라인: 315)
- *      - 명령행 인자 검사(argc != 2) 및 에러 처리:     (라인: 317-325)
- *      - SPL 소스 파일 열기(fopen):                    (라인: 326)
- *      - 한 줄씩 읽기 위한 메인 루프 시작(fgets):      (라인: 327)
+ *      - main 진입부 선언:                             (라인: 296)
+ *      - 화면 초기화(CLEAR) 호출:                     (라인: 333)
+ *      - 명령행 인자 검사(argc != 2) 및 에러 처리:     (라인: 336-342)
+ *      - SPL 소스 파일 열기(fopen):                    (라인: 345)
+ *      - 한 줄씩 읽기 위한 메인 루프 시작(fgets):      (라인: 354)
  *
  *   2) 라인 단위 파싱:
  *      - 읽은 라인을 토큰화하여 키워드를 판별하고 다음을 수행:
  *
  *        (1) 함수 선언(function):
- *            - 함수 처리 시작(토큰 비교):              (라인: 418)
- *            - 함수 선언을 스택에 기록(함수명, 시작 라인): (라인: 423-427)
+ *            - 함수 처리 시작(토큰 비교):              (라인: 449)
+ *            - 함수 선언을 스택에 기록(함수명, 시작 라인): (라인: 454-458)
  *
  *        (2) 변수 선언(int):
- *            - 변수 선언 처리(토큰 비교):               (라인: 395)
- *            - 변수 값을 스택에 저장:                  (라인: 413-415)
+ *            - 변수 선언 처리(토큰 비교):               (라인: 425)
+ *            - 변수 값을 스택에 저장:                  (라인: 443-445)
  *
  *        (3) 블록(begin/end):
- *            - begin 처리(스택에 begin 표시):          (라인: 346-351)
- *            - end 처리(스택에 end 표시 및 반환 검사): (라인: 354-363)
- *            - 함수 호출이 있는 경우 파일 재위치 및 복귀 처리: (라인: 372-386)
+ *            - begin 처리(스택에 begin 표시):          (라인: 374-381)
+ *            - end 처리(스택에 end 표시 및 반환 검사): (라인: 383-395)
+ *            - 함수 호출이 있는 경우 파일 재위치 및 복귀 처리: (라인: 396-416)
  *
  *        (4) 식 계산((...)):
- *            - 식 토큰 판별(괄호 시작):                (라인: 447)
- *            - 중위->후위 변환 루프 시작:               (라인: 456)
- *            - 연산자 우선순위 판정/스택 처리:          (라인: 471-489)
- *            - 식 내 식별자 처리(변수/함수 구분):       (라인: 491-511)
- *            - 함수 호출 시 콜 프레임 푸시:             (라인: 507-510)
- *            - 호출 대상 함수로 파일 포인터 이동(fclose/fopen): (라인: 513-515)
- *            - 후위식 계산 루프 시작:                   (라인: 552)
- *            - 계산 결과 저장(LastExpReturn):          (라인: 575)
+ *            - 식 토큰 판별(괄호 시작):                (라인: 479)
+ *            - 중위->후위 변환 루프 시작:               (라인: 489)
+ *            - 연산자 우선순위 판정/스택 처리:          (라인: 505-524)
+ *            - 식 내 식별자 처리(변수/함수 구분):       (라인: 526-573)
+ *            - 함수 호출 시 콜 프레임 푸시:             (라인: 543-545)
+ *            - 호출 대상 함수로 파일 포인터 이동(fclose/fopen): (라인: 551-559)
+ *            - 후위식 계산 루프 시작:                   (라인: 591)
+ *            - 계산 결과 저장(LastExpReturn):          (라인: 615)
  *
  *   3) 함수 호출 처리:
- *      - 함수 호출 시 콜 프레임(push) 및 라인 이동:    (라인: 507-515)
- *      - 함수 내 end에서 부모로 반환값 전달 처리:      (라인: 358-366, 371)
+ *      - 함수 호출 시 콜 프레임(push) 및 라인 이동:    (라인: 543-559)
+ *      - 함수 내 end에서 부모로 반환값 전달 처리:      (라인: 400-415)
  *
  *   4) 프로그램 종료:
- *      - 파일 닫기(fclose) 및 스택 정리(FreeAll):      (라인: 583-584)
- *      - 프로그램 종료(return 0):                     (라인: 588)
+ *      - 파일 닫기(fclose) 및 스택 정리(FreeStacks):   (라인: 623-624)
+ *      - 프로그램 종료(return 0):                     (라인: 628)
  *
  *  입력:
  *    - 명령행 인자: SPL 소스 파일 경로
@@ -305,6 +322,7 @@ int main(int argc, char** argv)
 
     if (!MathStack || !CalcStack || !STACK) {
         printf("Memory alloc failed\n");
+        free(MathStack); free(CalcStack); free(STACK);
         return 1;
     }
     MathStack->top = NULL;
@@ -319,6 +337,7 @@ int main(int argc, char** argv)
     {
         printf("Incorrect arguments!\n");
         printf("Usage: %s <inputfile.spl>", argv[0]);
+        FreeStacks(MathStack, CalcStack, STACK);
         return 1;
     }
 
@@ -327,6 +346,7 @@ int main(int argc, char** argv)
     if (filePtr == NULL)
     {
         printf("Can't open %s. Check the file please", argv[1]);
+        FreeStacks(MathStack, CalcStack, STACK);
         return 2;
     }
 
@@ -463,7 +483,7 @@ int main(int argc, char** argv)
                     int i = 0;
                     int y = 0;
 
-                    MathStack->top = NULL;
+                    while (!isStackEmpty(MathStack)) PopOp(MathStack);
 
                     /* SECTION: 중위->후위 변환 루프 시작 — lineyedek 문자 하나씩 분석 */
                     while (lineyedek[i] != '\0')
@@ -567,7 +587,7 @@ int main(int argc, char** argv)
 
                         i = 0;
                         /* SECTION: 후위식 계산 루프 — 후위 문자열을 스캔하며 스택으로 계산 */
-                        CalcStack->top = NULL;
+                        while (CalcStack->top) PopPostfix(CalcStack);
                         while (postfix[i] != '\0')
                         {
                             if (isdigit((unsigned char)postfix[i]))
@@ -601,7 +621,7 @@ int main(int argc, char** argv)
     }
 
     fclose(filePtr);
-    STACK = FreeAll(STACK);
+    FreeStacks(MathStack, CalcStack, STACK);
 
     printf("\nPress a key to exit...");
     getch();
@@ -620,6 +640,16 @@ static Stack* FreeAll(Stack* stck)
     return NULL;
 }
 
+static void FreeStacks(OpStack* opstck, PostfixStack* poststck, Stack* stck)
+{
+    while (!isStackEmpty(opstck)) PopOp(opstck);
+    while (poststck->top) PopPostfix(poststck);
+    FreeAll(stck);
+    free(opstck);
+    free(poststck);
+    free(stck);
+}
+
 static int GetLastFunctionCall(Stack* stck)
 {
     Node* head = stck->top;
@@ -0,0 +1,914 @@
+/* SPL differential fuzzer */
+/* Code licenced under GPL */
+
+/*
+ * spl_fuzz.c
+ *  - 임의의 올바른(well-formed) SPL 프로그램을 생성해 기준 인터프리터(basic_interpreter.c)와
+ *    등록된 모든 최적화 엔진을 같은 프로세스 안에서 실행하고 "Output=" 결과를 비교한다.
+ *  - 결과가 다르면 프로그램을 최소화하여 출력/저장하고, 케이스마다 엔진별 처리량(runs/s)을 기록한다.
+ *  - 기준 인터프리터의 처리량에는 실행마다(그리고 함수 호출/복귀마다) 파일을 다시 여는 비용이
+ *    포함된다. src를 메모리에서 읽는 엔진은 이 비용을 내지 않으므로 비교할 때 감안해야 한다.
+ *  - 기준보다 FZ_SLOWER_MARGIN 이상 느린 엔진이 있으면 해당 프로그램을 spl_fuzz_slow_<케이스>.spl로 저장한다.
+ *
+ *  빌드:  cc -O2 -o spl_fuzz spl_fuzz.c      (basic_interpreter.c를 SPL_EMBED로 포함함)
+ *  실행:  spl_fuzz [-n 케이스수] [-seed 시드] [-iters 측정 묶음 크기] [-csv 파일] [-tmp 임시파일]
+ *
+ *  종료 코드: 불일치가 없으면 0, 하나라도 있으면 1, 인자 오류는 2.
+ */
+
+#define SPL_EMBED
+#include "basic_interpreter.c"
+#undef main
+#undef printf
+
+#include <stdarg.h>
+#include <time.h>
+
+#define FZ_MAX_FUNCS 4      /* main을 제외한 함수 최대 개수 */
+#define FZ_MAX_STMTS 6      /* 함수 본문의 최대 문장 수 */
+#define FZ_MAX_NODES 32     /* 식 하나의 최대 노드 수 */
+#define FZ_MAX_ENV 256      /* 검사기 심볼 스택 크기 */
+#define FZ_MAX_SRC 8192     /* 렌더링된 프로그램 최대 크기 */
+#define FZ_MAX_OUT 1024     /* 엔진 출력 버퍼 크기 */
+#define FZ_MAX_TRIES 200    /* 케이스 하나를 만들 때 생성 재시도 횟수 */
+#define FZ_VALUE_LIMIT 100000
+#define FZ_TIME_REPS 5      /* 처리량 측정 반복 횟수 (가장 빠른 값을 사용) */
+#define FZ_TIME_MIN_SEC 0.002   /* 측정 한 번의 최소 시간(초) */
+#define FZ_SLOWER_MARGIN 0.10   /* 기준보다 이 비율 이상 느릴 때만 "느림"으로 표시 */
+
+/*
+ * FzNode / FzStmt / FzFunc / FzProgram
+ *  - 생성기가 만드는 구조화된 프로그램. 최소화는 텍스트가 아니라 이 구조 위에서 수행한다.
+ *  - FzNode.kind: 'n' 숫자(ch), 'v' 변수(ch), 'c' 함수 호출(ch(arg)), 'b' 이항 연산(op, lhs, rhs)
+ *  - FzStmt.kind: 'd' 변수 선언(int name = val;), 'e' 식((...);), spaced: 토큰 사이 공백을 넉넉히 둘지 여부
+ */
+typedef struct { char kind; char ch; char arg; char op; char paren; int lhs; int rhs; } FzNode;
+typedef struct { char kind; char name; char spaced; int val; int root; int nnode; FzNode node[FZ_MAX_NODES]; } FzStmt;
+typedef struct { char name; char param; int nstmt; FzStmt stmt[FZ_MAX_STMTS]; } FzFunc;
+
+typedef struct {
+    int nfunc;                          /* 마지막 함수가 항상 main */
+    FzFunc func[FZ_MAX_FUNCS + 1];
+    int indent;                         /* 0: 없음, 1: 공백, 2: 탭 */
+    int upper;                          /* 키워드 대문자 사용 여부 */
+    int crlf;                           /* CRLF 줄바꿈 사용 여부 */
+} FzProgram;
+
+/*
+ * FzEnv
+ *  - 기준 인터프리터의 STACK을 흉내낸 검사기용 심볼 스택.
+ *    type: 1 변수, 2 함수, 3 함수 호출 (basic_interpreter.c의 Node.type과 같은 의미)
+ */
+typedef struct { char name; int type; int val; } FzSym;
+typedef struct {
+    const FzProgram* prog;
+    FzSym sym[FZ_MAX_ENV];
+    int nsym;
+    int lastExp;                        /* LastExpReturn */
+    int depth;
+} FzEnv;
+
+/*
+ * SplEngine
+ *  - 비교 대상 엔진. run은 path(디스크에 기록된 프로그램)나 src(같은 내용의 메모리 사본) 중
+ *    편한 쪽을 읽어 프로그램 출력(종료 안내문 제외)을 out에 기록하고, 성공하면 0을 반환한다.
+ */
+typedef struct {
+    const char* name;
+    int (*run)(const char* path, const char* src, char* out, size_t outsz);
+} SplEngine;
+
+/* 기준 인터프리터 출력 캡처 버퍼 (SplEmbedPrintf가 채움) */
+static char g_capture[FZ_MAX_OUT];
+static size_t g_captureLen;
+
+static unsigned long g_rng = 1;
+
+static int RunReference(const char* path, const char* src, char* out, size_t outsz);
+
+/*
+ * g_engines
+ *  - 첫 항목은 항상 기준 인터프리터이며 나머지 엔진은 모두 이 결과와 비교된다.
+ *  - AST, 바이트코드, JIT, 인라이닝, 상수 접기 등 새 엔진은 이 표에 한 줄 추가해 등록한다.
+ */
+static const SplEngine g_engines[] = {
+    { "reference", RunReference },
+};
+#define FZ_NENGINES ((int)(sizeof(g_engines) / sizeof(g_engines[0])))
+
+/*
+ * SplEmbedPrintf
+ *  - SPL_EMBED로 포함된 기준 인터프리터의 printf 대체 함수. 출력을 g_capture에 덧붙인다.
+ */
+int SplEmbedPrintf(const char* fmt, ...)
+{
+    va_list ap;
+    int n;
+    va_start(ap, fmt);
+    n = vsnprintf(g_capture + g_captureLen, sizeof(g_capture) - g_captureLen, fmt, ap);
+    va_end(ap);
+    if (n > 0)
+    {
+        g_captureLen += (size_t)n;
+        if (g_captureLen >= sizeof(g_capture)) g_captureLen = sizeof(g_capture) - 1;
+    }
+    return n;
+}
+
+/*
+ * RunReference
+ *  - 기준 인터프리터를 같은 프로세스에서 실행하고 종료 안내문을 떼어낸 출력을 돌려준다.
+ */
+static int RunReference(const char* path, const char* src, char* out, size_t outsz)
+{
+    static const char trailer[] = "\nPress a key to exit...";
+    char* argv[3];
+    size_t tlen = sizeof(trailer) - 1;
+    int rc;
+
+    (void)src;
+    argv[0] = "spl_reference";
+    argv[1] = (char*)path;
+    argv[2] = NULL;
+
+    g_captureLen = 0;
+    g_capture[0] = '\0';
+    rc = spl_reference_main(2, argv);
+
+    if (g_captureLen >= tlen && strcmp(g_capture + g_captureLen - tlen, trailer) == 0)
+    {
+        g_captureLen -= tlen;
+        g_capture[g_captureLen] = '\0';
+    }
+    snprintf(out, outsz, "%s", g_capture);
+    return rc;
+}
+
+/* ---------------------------------------------------------------- 난수 */
+
+static int FzRand(int n)
+{
+    g_rng = (g_rng * 1103515245UL + 12345UL) & 0xffffffffUL;
+    return (int)((g_rng >> 16) % (unsigned long)n);
+}
+
+static char FzPick(const char* pool)
+{
+    return pool[FzRand((int)strlen(pool))];
+}
+
+/* ---------------------------------------------------------------- 렌더링 */
+
+static void FzAppend(char* buf, size_t bufsz, const char* s)
+{
+    size_t len = strlen(buf);
+    if (len + 1 < bufsz) snprintf(buf + len, bufsz - len, "%s", s);
+}
+
+static void FzRenderNode(const FzStmt* st, int k, char* buf, size_t bufsz)
+{
+    const FzNode* n = &st->node[k];
+    char tmp[8];
+
+    switch (n->kind)
+    {
+    case 'n':
+    case 'v':
+        tmp[0] = n->ch; tmp[1] = '\0';
+        FzAppend(buf, bufsz, tmp);
+        break;
+    case 'c':
+        tmp[0] = n->ch; tmp[1] = '('; tmp[2] = n->arg; tmp[3] = ')'; tmp[4] = '\0';
+        FzAppend(buf, bufsz, tmp);
+        break;
+    default:
+        if (n->paren) FzAppend(buf, bufsz, "(");
+        FzRenderNode(st, n->lhs, buf, bufsz);
+        tmp[0] = ' '; tmp[1] = n->op; tmp[2] = ' '; tmp[3] = '\0';
+        if (!st->spaced) { tmp[0] = n->op; tmp[1] = '\0'; }
+        FzAppend(buf, bufsz, tmp);
+        FzRenderNode(st, n->rhs, buf, bufsz);
+        if (n->paren) FzAppend(buf, bufsz, ")");
+        break;
+    }
+}
+
+/*
+ * FzRenderStmt
+ *  - 문장 하나를 들여쓰기 없이 한 줄 텍스트로 만든다. 식 문장은 항상 '('로 시작해야
+ *    기준 인터프리터가 식으로 인식하므로 전체를 한 번 더 괄호로 감싼다.
+ */
+static void FzRenderStmt(const FzStmt* st, int upper, char* buf, size_t bufsz)
+{
+    const char* gap = st->spaced ? "  " : " ";
+    buf[0] = '\0';
+    if (st->kind == 'd')
+    {
+        snprintf(buf, bufsz, "%s%s%c%s=%s%d;", upper ? "INT" : "int", gap, st->name, gap, gap, st->val);
+    }
+    else
+    {
+        FzAppend(buf, bufsz, "(");
+        FzRenderNode(st, st->root, buf, bufsz);
+        FzAppend(buf, bufsz, ");");
+    }
+}
+
+/*
+ * FzRenderProgram
+ *  - 프로그램 구조를 SPL 소스 텍스트로 만든다. begin/end는 기준 인터프리터가 줄 전체를
+ *    비교하므로 들여쓰지 않는다.
+ */
+static void FzRenderProgram(const FzProgram* prog, char* src, size_t srcsz)
+{
+    static const char* indents[] = { "", "   ", "\t" };
+    const char* nl = prog->crlf ? "\r\n" : "\n";
+    char line[512];
+    int f, s;
+
+    src[0] = '\0';
+    for (f = 0; f < prog->nfunc; f++)
+    {
+        const FzFunc* fn = &prog->func[f];
+        if (f == prog->nfunc - 1)
+            snprintf(line, sizeof(line), "%s main()%s", prog->upper ? "FUNCTION" : "function", nl);
+        else
+            snprintf(line, sizeof(line), "%s %c(int %c)%s", prog->upper ? "FUNCTION" : "function", fn->name, fn->param, nl);
+        FzAppend(src, srcsz, line);
+        FzAppend(src, srcsz, prog->upper ? "BEGIN" : "begin");
+        FzAppend(src, srcsz, nl);
+        for (s = 0; s < fn->nstmt; s++)
+        {
+            FzAppend(src, srcsz, indents[prog->indent]);
+            FzRenderStmt(&fn->stmt[s], prog->upper, line, sizeof(line));
+            FzAppend(src, srcsz, line);
+            if (fn->stmt[s].spaced) FzAppend(src, srcsz, " ");
+            FzAppend(src, srcsz, nl);
+        }
+        FzAppend(src, srcsz, prog->upper ? "END" : "end");
+        FzAppend(src, srcsz, nl);
+        if (f < prog->nfunc - 1) FzAppend(src, srcsz, nl);
+    }
+}
+
+/* ---------------------------------------------------------------- 검사기 */
+
+/*
+ * 검사기는 생성된 프로그램이 기준 인터프리터에서 정의된 동작을 하는지 판단하고 기대 출력을 계산한다.
+ * 한 자리 피연산자, 식 하나에 함수 호출 하나, 0으로 나누기 금지처럼 기준 인터프리터가
+ * 올바르게 처리하지 못하는 프로그램은 무효로 보고 다시 생성한다.
+ */
+static int FzCall(FzEnv* env, char name, int arg, int* ret);
+
+static int FzLookup(const FzEnv* env, char name, int* type, int* val)
+{
+    int k;
+    for (k = env->nsym - 1; k >= 0; k--)
+    {
+        if (env->sym[k].name == name && (env->sym[k].type == 1 || env->sym[k].type == 2))
+        {
+            *type = env->sym[k].type;
+            *val = env->sym[k].val;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static int FzPush(FzEnv* env, char name, int type, int val)
+{
+    if (env->nsym >= FZ_MAX_ENV) return 0;
+    env->sym[env->nsym].name = name;
+    env->sym[env->nsym].type = type;
+    env->sym[env->nsym].val = val;
+    env->nsym++;
+    return 1;
+}
+
+/*
+ * FzEvalLine
+ *  - 식 한 줄을 기준 인터프리터와 같은 규칙(단순화된 중위->후위 변환, 문자 단위 피연산자)으로 계산한다.
+ *  - 출력: 유효하면 1과 *result, 무효하면 0
+ */
+static int FzEvalLine(FzEnv* env, const char* text, int* result)
+{
+    char postfix[512];
+    char ops[512];
+    int calc[512];
+    int nops = 0;
+    int ncalc = 0;
+    int calls = 0;
+    int y = 0;
+    int i;
+
+    for (i = 0; text[i] != '\0'; i++)
+    {
+        char c = text[i];
+        if (isdigit((unsigned char)c))
+        {
+            postfix[y++] = c;
+        }
+        else if (c == ')')
+        {
+            if (nops > 0) postfix[y++] = ops[--nops];
+        }
+        else if (c == '+' || c == '-' || c == '*' || c == '/')
+        {
+            if (nops > 0 && Priotry(c) <= Priotry(ops[nops - 1])) postfix[y++] = ops[--nops];
+            ops[nops++] = c;
+        }
+        else if (isalpha((unsigned char)c))
+        {
+            int type, val;
+            if (!FzLookup(env, c, &type, &val)) return 0;
+            if (type == 2)
+            {
+                int argType, argVal;
+                if (calls++ > 0 || text[i + 1] != '(') return 0;
+                if (!FzLookup(env, text[i + 2], &argType, &argVal) || argType != 1) return 0;
+                if (!FzCall(env, c, argVal, &val)) return 0;
+                i += 3;
+            }
+            if (val < 0 || val > 9) return 0;
+            postfix[y++] = (char)('0' + val);
+        }
+    }
+    while (nops > 0) postfix[y++] = ops[--nops];
+
+    for (i = 0; i < y; i++)
+    {
+        if (isdigit((unsigned char)postfix[i]))
+        {
+            calc[ncalc++] = postfix[i] - '0';
+        }
+        else
+        {
+            int v1, v2, r = 0;
+            if (ncalc < 2) return 0;
+            v1 = calc[--ncalc];
+            v2 = calc[--ncalc];
+            switch (postfix[i])
+            {
+            case '+': r = v2 + v1; break;
+            case '-': r = v2 - v1; break;
+            case '*': r = v2 * v1; break;
+            case '/':
+                if (v1 == 0) return 0;
+                r = v2 / v1;
+                break;
+            }
+            if (r > FZ_VALUE_LIMIT || r < -FZ_VALUE_LIMIT) return 0;
+            calc[ncalc++] = r;
+        }
+    }
+    if (ncalc == 0) return 0;
+    *result = calc[ncalc - 1];
+    return 1;
+}
+
+/*
+ * FzExecBody
+ *  - 함수 본문의 문장을 차례로 실행한다. 변수 선언은 스택에 푸시하고, 식은 LastExpReturn을 갱신한다.
+ */
+static int FzExecBody(FzEnv* env, const FzFunc* fn)
+{
+    char text[512];
+    int s, r;
+
+    for (s = 0; s < fn->nstmt; s++)
+    {
+        const FzStmt* st = &fn->stmt[s];
+        if (st->kind == 'd')
+        {
+            if (!FzPush(env, st->name, 1, st->val)) return 0;
+        }
+        else
+        {
+            FzRenderStmt(st, 0, text, sizeof(text));
+            if (!FzEvalLine(env, text, &r)) return 0;
+            env->lastExp = r;
+        }
+    }
+    return 1;
+}
+
+/*
+ * FzCall
+ *  - 함수 호출을 흉내낸다. 콜 프레임(type 3), 함수 노드, 매개변수를 푸시한 뒤 본문을 실행하고,
+ *    end에서처럼 콜 프레임까지 스택을 되돌린다. 반환값은 마지막 식의 결과(LastExpReturn)이다.
+ */
+static int FzCall(FzEnv* env, char name, int arg, int* ret)
+{
+    const FzFunc* fn = NULL;
+    int frame = env->nsym;
+    int f;
+
+    for (f = 0; f < env->prog->nfunc - 1; f++)
+    {
+        if (env->prog->func[f].name == name) fn = &env->prog->func[f];
+    }
+    if (!fn || env->depth >= FZ_MAX_FUNCS) return 0;
+
+    env->depth++;
+    if (!FzPush(env, ' ', 3, 0) || !FzPush(env, fn->name, 2, 0) || !FzPush(env, fn->param, 1, arg)) return 0;
+    if (!FzExecBody(env, fn)) return 0;
+    *ret = env->lastExp;
+    env->nsym = frame;
+    env->depth--;
+    return 1;
+}
+
+/*
+ * FzCheck
+ *  - 프로그램 전체를 검사하고, 유효하면 1과 기대 출력("Output=N")을 돌려준다.
+ *  - main 이전의 함수 선언은 기준 인터프리터의 첫 훑기처럼 함수 노드만 푸시한다.
+ */
+static int FzCheck(const FzProgram* prog, char* expected, size_t expsz)
+{
+    static FzEnv env;
+    int f;
+
+    env.prog = prog;
+    env.nsym = 0;
+    env.lastExp = 0;
+    env.depth = 0;
+
+    for (f = 0; f < prog->nfunc; f++)
+    {
+        if (!FzPush(&env, prog->func[f].name, 2, 0)) return 0;
+    }
+    if (!FzExecBody(&env, &prog->func[prog->nfunc - 1])) return 0;
+    snprintf(expected, expsz, "Output=%d", env.lastExp);
+    return 1;
+}
+
+/* ---------------------------------------------------------------- 생성기 */
+
+static int FzNewNode(FzStmt* st, char kind)
+{
+    FzNode* n;
+    if (st->nnode >= FZ_MAX_NODES) return -1;
+    n = &st->node[st->nnode];
+    memset(n, 0, sizeof(*n));
+    n->kind = kind;
+    n->lhs = n->rhs = -1;
+    return st->nnode++;
+}
+
+/*
+ * FzGenExpr
+ *  - 깊이 제한이 있는 임의의 식 트리를 만든다.
+ *  - vars: 현재 보이는 변수들, callees: 호출 가능한 함수들 (재귀를 막기 위해 앞서 정의된 함수만)
+ *  - calls: 지금까지 만든 호출 수. 기준 인터프리터는 식 하나에 호출 하나만 올바르게 처리한다.
+ */
+static int FzGenExpr(FzStmt* st, int depth, const char* vars, const char* callees, int* calls)
+{
+    int roll = FzRand(10);
+    int k;
+
+    if (depth > 0 && roll < 5)
+    {
+        int lhs, rhs;
+        k = FzNewNode(st, 'b');
+        if (k < 0) return -1;
+        lhs = FzGenExpr(st, depth - 1, vars, callees, calls);
+        rhs = FzGenExpr(st, depth - 1, vars, callees, calls);
+        if (lhs < 0 || rhs < 0) return -1;
+        st->node[k].op = FzPick("+-*/");
+        st->node[k].paren = (char)FzRand(2);
+        st->node[k].lhs = lhs;
+        st->node[k].rhs = rhs;
+        return k;
+    }
+    if (roll < 7 && callees[0] && vars[0] && *calls == 0)
+    {
+        k = FzNewNode(st, 'c');
+        if (k < 0) return -1;
+        st->node[k].ch = FzPick(callees);
+        st->node[k].arg = FzPick(vars);
+        (*calls)++;
+        return k;
+    }
+    if (roll < 9 && vars[0])
+    {
+        k = FzNewNode(st, 'v');
+        if (k < 0) return -1;
+        st->node[k].ch = FzPick(vars);
+        return k;
+    }
+    k = FzNewNode(st, 'n');
+    if (k < 0) return -1;
+    st->node[k].ch = (char)('0' + FzRand(10));
+    return k;
+}
+
+/*
+ * FzGenFunc
+ *  - 함수 본문을 만든다. 변수 선언과 식을 섞되 마지막 문장은 항상 식이 되게 한다.
+ */
+static int FzGenFunc(FzFunc* fn, const char* varPool, const char* callees, int isMain)
+{
+    char vars[32];
+    int nvars = 0;
+    int declLeft = FzRand(4);
+    int exprLeft = 1 + FzRand(2);
+
+    memset(vars, 0, sizeof(vars));
+    if (!isMain)
+    {
+        fn->param = FzPick(varPool);
+        vars[nvars++] = fn->param;
+    }
+    while (declLeft + exprLeft > 0)
+    {
+        FzStmt* st = &fn->stmt[fn->nstmt++];
+        st->spaced = (char)FzRand(2);
+        /* 식 하나는 끝까지 남겨 두어 본문이 항상 식으로 끝나게 한다 */
+        if (declLeft > 0 && FzRand(declLeft + exprLeft - 1) < declLeft)
+        {
+            st->kind = 'd';
+            st->name = FzPick(varPool);
+            st->val = FzRand(10);
+            if (!strchr(vars, st->name)) vars[nvars++] = st->name;
+            declLeft--;
+        }
+        else
+        {
+            int calls = 0;
+            st->kind = 'e';
+            st->root = FzGenExpr(st, 1 + FzRand(3), vars, callees, &calls);
+            if (st->root < 0) return 0;
+            exprLeft--;
+        }
+    }
+    return 1;
+}
+
+/*
+ * FzGenProgram
+ *  - 임의의 프로그램 구조를 만든다. 함수 이름과 변수 이름은 서로 겹치지 않는 한 글자로 고르며,
+ *    'm'은 main 함수 노드와 충돌하므로 쓰지 않는다.
+ */
+static int FzGenProgram(FzProgram* prog)
+{
+    static const char funcPool[] = "fghjkl";
+    static const char varPool[] = "abcdenopqrstuvwxyz";
+    char callees[FZ_MAX_FUNCS + 1];
+    int nfunc = FzRand(FZ_MAX_FUNCS + 1);
+    int f;
+
+    memset(prog, 0, sizeof(*prog));
+    memset(callees, 0, sizeof(callees));
+    prog->nfunc = nfunc + 1;
+    prog->indent = FzRand(3);
+    prog->upper = FzRand(4) == 0;
+    prog->crlf = FzRand(4) == 0;
+
+    for (f = 0; f < nfunc; f++)
+    {
+        char name;
+        do { name = FzPick(funcPool); } while (strchr(callees, name));
+        prog->func[f].name = name;
+        if (!FzGenFunc(&prog->func[f], varPool, callees, 0)) return 0;
+        callees[f] = name;
+    }
+    prog->func[nfunc].name = 'm';
+    return FzGenFunc(&prog->func[nfunc], varPool, callees, 1);
+}
+
+/* ---------------------------------------------------------------- 실행 / 최소화 */
+
+/*
+ * FzWriteSource
+ *  - 렌더링된 프로그램을 path에 기록한다. 기준 인터프리터는 파일 경로만 받으므로 필요하다.
+ */
+static int FzWriteSource(const char* path, const char* src)
+{
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL) return 0;
+    fputs(src, fp);
+    fclose(fp);
+    return 1;
+}
+
+/*
+ * FzFails
+ *  - 프로그램이 여전히 유효하면서 engine이 틀린 결과를 내는지 검사한다. 최소화의 판정 함수.
+ *    기준 인터프리터(0번)는 검사기의 기대 출력과, 나머지 엔진은 기준 인터프리터의 출력과 비교한다.
+ */
+static int FzFails(const FzProgram* prog, int engine, const char* path)
+{
+    static char src[FZ_MAX_SRC];
+    char expected[FZ_MAX_OUT];
+    char refOut[FZ_MAX_OUT];
+    char out[FZ_MAX_OUT];
+
+    if (!FzCheck(prog, expected, sizeof(expected))) return 0;
+    FzRenderProgram(prog, src, sizeof(src));
+    if (!FzWriteSource(path, src)) return 0;
+
+    g_engines[0].run(path, src, refOut, sizeof(refOut));
+    if (engine == 0) return strcmp(refOut, expected) != 0;
+    g_engines[engine].run(path, src, out, sizeof(out));
+    return strcmp(out, refOut) != 0;
+}
+
+/*
+ * FzMinimize
+ *  - 실패를 유지하는 한에서 함수, 문장, 식의 부분 트리, 서식을 하나씩 줄여 나간다.
+ *    더 이상 줄일 수 없을 때까지 반복한다.
+ */
+static void FzMinimize(FzProgram* prog, int engine, const char* path)
+{
+    static FzProgram cand;
+    int changed = 1;
+
+    while (changed)
+    {
+        int f, s, k;
+        int formatted;
+        changed = 0;
+
+        /* main이 아닌 함수 통째로 제거 */
+        for (f = 0; f < prog->nfunc - 1; f++)
+        {
+            cand = *prog;
+            memmove(&cand.func[f], &cand.func[f + 1], (size_t)(cand.nfunc - f - 1) * sizeof(FzFunc));
+            cand.nfunc--;
+            if (FzFails(&cand, engine, path)) { *prog = cand; changed = 1; f--; }
+        }
+
+        for (f = 0; f < prog->nfunc; f++)
+        {
+            /* 문장 제거 */
+            for (s = 0; s < prog->func[f].nstmt; s++)
+            {
+                FzFunc* fn;
+                cand = *prog;
+                fn = &cand.func[f];
+                memmove(&fn->stmt[s], &fn->stmt[s + 1], (size_t)(fn->nstmt - s - 1) * sizeof(FzStmt));
+                fn->nstmt--;
+                if (FzFails(&cand, engine, path)) { *prog = cand; changed = 1; s--; }
+            }
+
+            /* 식 단순화: 이항 연산을 한쪽 피연산자로, 피연산자를 숫자 1로, 괄호 제거 */
+            for (s = 0; s < prog->func[f].nstmt; s++)
+            {
+                if (prog->func[f].stmt[s].kind != 'e') continue;
+                for (k = 0; k < prog->func[f].stmt[s].nnode; k++)
+                {
+                    const FzNode* n = &prog->func[f].stmt[s].node[k];
+                    FzNode repl[4];
+                    int nrepl = 0;
+                    int r;
+
+                    if (n->kind == 'b')
+                    {
+                        repl[nrepl++] = prog->func[f].stmt[s].node[n->lhs];
+                        repl[nrepl++] = prog->func[f].stmt[s].node[n->rhs];
+                        if (n->paren) { repl[nrepl] = *n; repl[nrepl++].paren = 0; }
+                    }
+                    if (n->kind != 'n' || n->ch != '1')
+                    {
+                        memset(&repl[nrepl], 0, sizeof(FzNode));
+                        repl[nrepl].kind = 'n';
+                        repl[nrepl].ch = '1';
+                        repl[nrepl].lhs = repl[nrepl].rhs = -1;
+                        nrepl++;
+                    }
+                    for (r = 0; r < nrepl; r++)
+                    {
+                        cand = *prog;
+                        cand.func[f].stmt[s].node[k] = repl[r];
+                        if (FzFails(&cand, engine, path)) { *prog = cand; changed = 1; break; }
+                    }
+                }
+            }
+        }
+
+        /* 서식 단순화 (이미 단순한 서식이면 건너뛴다) */
+        cand = *prog;
+        formatted = cand.indent || cand.upper || cand.crlf;
+        cand.indent = 0;
+        cand.upper = 0;
+        cand.crlf = 0;
+        for (f = 0; f < cand.nfunc; f++)
+        {
+            for (s = 0; s < cand.func[f].nstmt; s++)
+            {
+                if (cand.func[f].stmt[s].spaced) formatted = 1;
+                cand.func[f].stmt[s].spaced = 0;
+            }
+        }
+        if (formatted && FzFails(&cand, engine, path)) { *prog = cand; changed = 1; }
+    }
+}
+
+/*
+ * FzTime
+ *  - 엔진을 iters번씩 묶어, 최소 FZ_TIME_MIN_SEC 동안 실행하고 1회당 걸린 시간(초)을 돌려준다.
+ *    clock 해상도보다 훨씬 긴 구간을 재므로 짧은 프로그램에서도 틱 오차가 작다.
+ *  - 출력: *runs에 이번 측정에서 실행한 횟수
+ */
+static double FzTime(const SplEngine* engine, const char* path, const char* src, int iters, long* runs)
+{
+    char out[FZ_MAX_OUT];
+    clock_t start = clock();
+    double sec;
+    int i;
+
+    *runs = 0;
+    do
+    {
+        for (i = 0; i < iters; i++) engine->run(path, src, out, sizeof(out));
+        *runs += iters;
+        sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+    } while (sec < FZ_TIME_MIN_SEC);
+    return sec / *runs;
+}
+
+/*
+ * FzReport
+ *  - 최소화된 실패 프로그램과 각 엔진의 출력을 보여주고 spl_fuzz_fail_<케이스>.spl로 저장한다.
+ */
+static void FzReport(const FzProgram* prog, int caseNo, int engine, const char* path)
+{
+    static char src[FZ_MAX_SRC];
+    char expected[FZ_MAX_OUT];
+    char out[FZ_MAX_OUT];
+    char failPath[64];
+    int e;
+
+    FzCheck(prog, expected, sizeof(expected));
+    FzRenderProgram(prog, src, sizeof(src));
+    FzWriteSource(path, src);
+
+    printf("\n[case %d] MISMATCH in engine '%s'\n", caseNo, g_engines[engine].name);
+    printf("  expected (model): %s\n", expected);
+    for (e = 0; e < FZ_NENGINES; e++)
+    {
+        g_engines[e].run(path, src, out, sizeof(out));
+        printf("  %-16s: %s\n", g_engines[e].name, out);
+    }
+    printf("---- minimized program ----\n%s---------------------------\n", src);
+
+    snprintf(failPath, sizeof(failPath), "spl_fuzz_fail_%d.spl", caseNo);
+    if (FzWriteSource(failPath, src)) printf("  saved to %s\n", failPath);
+}
+
+/*
+ * FzReportSlow
+ *  - 기준보다 느린 엔진과 처리량을 보여주고, 해당 프로그램을 spl_fuzz_slow_<케이스>.spl로 저장한다.
+ */
+static void FzReportSlow(const char* src, int caseNo, int engine, const double* bestSec)
+{
+    char slowPath[64];
+
+    snprintf(slowPath, sizeof(slowPath), "spl_fuzz_slow_%d.spl", caseNo);
+    printf("[case %d] engine '%s' slower than reference: %.1f vs %.1f runs/s", caseNo,
+        g_engines[engine].name, 1.0 / bestSec[engine], 1.0 / bestSec[0]);
+    if (FzWriteSource(slowPath, src)) printf(", saved to %s", slowPath);
+    printf("\n");
+}
+
+/*
+ * main
+ *  - 케이스마다 유효한 프로그램을 생성해 모든 엔진으로 실행하고, 결과 비교와 처리량 측정을 수행한다.
+ */
+int main(int argc, char** argv)
+{
+    static FzProgram prog;
+    static char src[FZ_MAX_SRC];
+    char expected[FZ_MAX_OUT];
+    char outs[FZ_NENGINES][FZ_MAX_OUT];
+    double totalSec[FZ_NENGINES];
+    long totalRuns[FZ_NENGINES];
+    int slowerCases[FZ_NENGINES];
+    const char* tmpPath = "spl_fuzz_case.spl";
+    const char* csvPath = NULL;
+    FILE* csv = NULL;
+    unsigned long seed = (unsigned long)time(NULL);
+    int cases = 1000;
+    int iters = 20;
+    int mismatches = 0;
+    int skipped = 0;
+    int c, e, a;
+
+    for (a = 1; a < argc; a++)
+    {
+        if (strcmp(argv[a], "-n") == 0 && a + 1 < argc) cases = atoi(argv[++a]);
+        else if (strcmp(argv[a], "-seed") == 0 && a + 1 < argc) seed = strtoul(argv[++a], NULL, 10);
+        else if (strcmp(argv[a], "-iters") == 0 && a + 1 < argc) iters = atoi(argv[++a]);
+        else if (strcmp(argv[a], "-csv") == 0 && a + 1 < argc) csvPath = argv[++a];
+        else if (strcmp(argv[a], "-tmp") == 0 && a + 1 < argc) tmpPath = argv[++a];
+        else
+        {
+            printf("Usage: %s [-n cases] [-seed N] [-iters K] [-csv file] [-tmp file]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (cases < 1 || iters < 1)
+    {
+        printf("-n and -iters must be positive\n");
+        return 2;
+    }
+    if (csvPath)
+    {
+        csv = fopen(csvPath, "w");
+        if (csv == NULL)
+        {
+            printf("Can't open %s\n", csvPath);
+            return 2;
+        }
+        fprintf(csv, "case,engine,runs,best_sec_per_run,runs_per_sec,slower_than_reference\n");
+    }
+
+    for (e = 0; e < FZ_NENGINES; e++)
+    {
+        totalSec[e] = 0.0;
+        totalRuns[e] = 0;
+        slowerCases[e] = 0;
+    }
+
+    printf("spl_fuzz: seed=%lu cases=%d iters=%d engines=%d\n", seed, cases, iters, FZ_NENGINES);
+    g_rng = seed;
+
+    for (c = 0; c < cases; c++)
+    {
+        double bestSec[FZ_NENGINES];
+        long caseRuns[FZ_NENGINES];
+        int tries, r;
+        int bad = -1;
+
+        /* SECTION: 유효한 프로그램이 나올 때까지 생성 */
+        for (tries = 0; tries < FZ_MAX_TRIES; tries++)
+        {
+            if (FzGenProgram(&prog) && FzCheck(&prog, expected, sizeof(expected))) break;
+        }
+        if (tries == FZ_MAX_TRIES) { skipped++; continue; }
+
+        FzRenderProgram(&prog, src, sizeof(src));
+        if (!FzWriteSource(tmpPath, src))
+        {
+            printf("Can't write %s\n", tmpPath);
+            return 2;
+        }
+
+        /* SECTION: 차등 비교 — 기준은 검사기와, 나머지 엔진은 기준과 비교 */
+        for (e = 0; e < FZ_NENGINES; e++) g_engines[e].run(tmpPath, src, outs[e], sizeof(outs[e]));
+        if (strcmp(outs[0], expected) != 0) bad = 0;
+        for (e = 1; e < FZ_NENGINES && bad < 0; e++)
+        {
+            if (strcmp(outs[e], outs[0]) != 0) bad = e;
+        }
+
+        /* SECTION: 처리량 측정 — 엔진들을 번갈아 FZ_TIME_REPS번 재고 가장 빠른 값을 사용 */
+        for (e = 0; e < FZ_NENGINES; e++)
+        {
+            bestSec[e] = 0.0;
+            caseRuns[e] = 0;
+        }
+        for (r = 0; r < FZ_TIME_REPS; r++)
+        {
+            for (e = 0; e < FZ_NENGINES; e++)
+            {
+                long runs;
+                double perRun = FzTime(&g_engines[e], tmpPath, src, iters, &runs);
+                if (r == 0 || perRun < bestSec[e]) bestSec[e] = perRun;
+                caseRuns[e] += runs;
+                totalSec[e] += perRun * runs;
+                totalRuns[e] += runs;
+            }
+        }
+        for (e = 0; e < FZ_NENGINES; e++)
+        {
+            int slower = e > 0 && bestSec[e] > bestSec[0] * (1.0 + FZ_SLOWER_MARGIN);
+            if (slower)
+            {
+                slowerCases[e]++;
+                FzReportSlow(src, c, e, bestSec);
+            }
+            if (csv) fprintf(csv, "%d,%s,%ld,%.9f,%.1f,%d\n", c, g_engines[e].name, caseRuns[e], bestSec[e], 1.0 / bestSec[e], slower);
+        }
+
+        /* SECTION: 불일치 시 최소화 후 보고 */
+        if (bad >= 0)
+        {
+            mismatches++;
+            FzMinimize(&prog, bad, tmpPath);
+            FzReport(&prog, c, bad, tmpPath);
+        }
+    }
+
+    printf("\n%-16s %12s %14s %14s\n", "engine", "runs", "runs/s", "slower cases");
+    for (e = 0; e < FZ_NENGINES; e++)
+    {
+        printf("%-16s %12ld %14.1f %14d\n", g_engines[e].name, totalRuns[e],
+            totalSec[e] > 0.0 ? totalRuns[e] / totalSec[e] : 0.0, slowerCases[e]);
+    }
+    printf("cases=%d skipped=%d mismatches=%d\n", cases, skipped, mismatches);
+
+    if (csv) fclose(csv);
+    remove(tmpPath);
+    return mismatches ? 1 : 0;
+}